@@ -0,0 +1,18 @@
+# map key hashes per identifier on a declaration- and macro-heavy input
+src=$(mktemp)
+trap 'rm "$src"' EXIT
+
+awk 'BEGIN {
+	for (i = 0; i < 2000; ++i) {
+		printf "#define M%d(x) ((x) + %d)\n", i, i
+		printf "struct s%d { int a, b; };\n", i
+		printf "static int v%d;\n", i
+		printf "int f%d(int a) { struct s%d s = {a, v%d}; int b = M%d(s.a); return b + s.b; }\n", i, i, i, i
+	}
+}' >"$src"
+
+"$CCQBE" -s -o /dev/null "$src" 2>&1 | awk '
+	/^identifiers scanned:/ { n = $3 }
+	/^map keys hashed:/ { h = $4 }
+	END { printf "%d identifiers, %d hashes, %.2f hashes per identifier\n", n, h, h / n }
+'
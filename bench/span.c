@@ -0,0 +1,102 @@
+/* throughput of the scanner's character-class kernels */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/cproc/util.c"
+#include "../src/cproc/span.c"
+
+enum { BUFLEN = 1<<24, ROUNDS = 8 };
+
+struct kernel {
+	const char *name;
+	const char *(*fn)(const char *, const char *);
+};
+
+static const char *
+untilquote(const char *p, const char *end)
+{
+	return spanuntil(p, end, '"', '\\', '\n');
+}
+
+static const char *
+untilquotescalar(const char *p, const char *end)
+{
+	return spanuntilscalar(p, end, '"', '\\', '\n');
+}
+
+static const char *
+untilstar(const char *p, const char *end)
+{
+	return spanuntil(p, end, '*', '\n', '*');
+}
+
+static const char *
+untilstarscalar(const char *p, const char *end)
+{
+	return spanuntilscalar(p, end, '*', '\n', '*');
+}
+
+/* fill a buffer with runs drawn from set, of average length run, separated by stop */
+static char *
+gen(const char *set, size_t run, int stop)
+{
+	char *buf;
+	size_t i, n;
+
+	buf = xmalloc(BUFLEN);
+	n = strlen(set);
+	for (i = 0; i < BUFLEN; ++i)
+		buf[i] = rand() % run ? set[rand() % n] : stop;
+	return buf;
+}
+
+static void
+bench(const char *buf, const struct kernel *k)
+{
+	const char *p, *end = buf + BUFLEN;
+	clock_t start;
+	double secs;
+	size_t runs;
+	int i;
+
+	runs = 0;
+	start = clock();
+	for (i = 0; i < ROUNDS; ++i) {
+		for (p = buf; p < end; ++p, ++runs)
+			p = k->fn(p, end);
+	}
+	secs = (double)(clock() - start) / CLOCKS_PER_SEC;
+	printf("%-14s %8.1f MB/s  (%zu runs)\n", k->name, (double)BUFLEN * ROUNDS / secs / 1e6, runs / ROUNDS);
+}
+
+int
+main(void)
+{
+	static const struct {
+		const char *set;
+		size_t run;
+		int stop;
+		struct kernel k[2];
+	} tests[] = {
+		{"abcdefghijklmnopqrstuvwxyz_0123456789ABCXYZ", 12, '(', {{"ident", spanident}, {"ident scalar", spanidentscalar}}},
+		{"    \t", 24, 'x', {{"blank", spanblank}, {"blank scalar", spanblankscalar}}},
+		{"abcd efgh/ijkl", 80, '*', {{"comment", untilstar}, {"comment scalar", untilstarscalar}}},
+		{"abcd efgh%ijkl", 40, '"', {{"string", untilquote}, {"string scalar", untilquotescalar}}},
+	};
+	char *buf;
+	size_t i;
+
+#ifdef SPANVEC
+	printf("vector width: %d bytes\n", SPANVEC);
+#else
+	printf("vector width: none\n");
+#endif
+	for (i = 0; i < LEN(tests); ++i) {
+		buf = gen(tests[i].set, tests[i].run, tests[i].stop);
+		bench(buf, &tests[i].k[0]);
+		bench(buf, &tests[i].k[1]);
+		free(buf);
+	}
+	return 0;
+}
@@ -118,17 +118,21 @@ enum tokenkind {
 	THASHHASH,
 };
 
+/*
+A position in the source, as an offset into the concatenation of all
+files in the order they were read. The file, line and column are only
+looked up when needed, with scanlocate. Offset 0 is an unknown location.
+*/
 struct location {
-	const char *file;
-	size_t line, col;
+	uint32_t off;
 };
 
 struct token {
-	enum tokenkind kind;
+	unsigned char kind;  /* enum tokenkind */
 	/* whether or not the token is ineligible for expansion */
-	_Bool hide;
+	_Bool hide : 1;
 	/* whether or not the token was preceeded by a space */
-	_Bool space;
+	_Bool space : 1;
 	struct location loc;
 	char *lit;
 };
@@ -388,6 +392,13 @@ _Noreturn void error(const struct location *, const char *, ...);
 void scanfrom(const char *, FILE *);
 void scanopen(void);
 void scan(struct token *);
+const char *scanlocate(const struct location *, size_t *, size_t *);
+
+/* span */
+
+const char *spanident(const char *, const char *);
+const char *spanblank(const char *, const char *);
+const char *spanuntil(const char *, const char *, int, int, int);
 
 /* preprocessor */
 
@@ -0,0 +1,52 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "util.h"
+
+/*
+Each distinct identifier is stored once, along with its hash, so that
+interned strings can be compared by pointer and used as map keys
+without hashing them again.
+*/
+struct atom {
+	uint64_t hash;
+	size_t len;
+	char str[];
+};
+
+static struct map *atoms;
+
+char *
+intern(const char *s, size_t n)
+{
+	struct mapkey k;
+	struct atom *a;
+
+	if (!atoms)
+		atoms = mkmap(1024);
+	mapkey(&k, s, n);
+	a = mapget(atoms, &k);
+	if (!a) {
+		a = xmalloc(sizeof(*a) + n + 1);
+		a->hash = k.hash;
+		a->len = n;
+		memcpy(a->str, s, n);
+		a->str[n] = '\0';
+		k.str = a->str;
+		*mapput(atoms, &k) = a;
+	}
+	return a->str;
+}
+
+/* make a map key for an interned string */
+void
+internkey(struct mapkey *k, const char *s)
+{
+	const struct atom *a;
+
+	a = (const struct atom *)(s - offsetof(struct atom, str));
+	k->hash = a->hash;
+	k->str = s;
+	k->len = a->len;
+}
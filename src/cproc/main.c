@@ -10,14 +10,21 @@
 static noreturn void
 usage(void)
 {
-	fprintf(stderr, "usage: %s [input]\n", argv0);
+	fprintf(stderr, "usage: %s [-Es] [-t target] [-o output] [input]\n", argv0);
 	exit(2);
 }
 
+static void
+printstats(void)
+{
+	fprintf(stderr, "identifiers scanned: %llu\n", stats.idents);
+	fprintf(stderr, "map keys hashed:     %llu\n", stats.hashes);
+}
+
 int
 cproc_main(int argc, char *argv[])
 {
-	bool pponly = false;
+	bool pponly = false, showstats = false;
 	char *output = NULL, *target = NULL;
 
 	argv0 = progname(argv[0], "cproc-qbe");
@@ -25,6 +32,9 @@ cproc_main(int argc, char *argv[])
 	case 'E':
 		pponly = true;
 		break;
+	case 's':
+		showstats = true;
+		break;
 	case 't':
 		target = EARGF(usage());
 		break;
@@ -67,5 +77,7 @@ cproc_main(int argc, char *argv[])
 	fflush(stdout);
 	if (ferror(stdout))
 		fatal("write failed");
+	if (showstats)
+		printstats();
 	return 0;
 }
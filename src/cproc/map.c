@@ -18,6 +18,7 @@ hash(const void *ptr, size_t len)
 	static const uint8_t k[16] = {0};  // XXX: we don't have a way to get entropy in standard C
 	uint64_t r;
 
+	++stats.hashes;
 	siphash(ptr, len, k, (uint8_t *)&r, sizeof(r));
 
 	return r;
@@ -72,7 +73,7 @@ keyequal(struct mapkey *k1, struct mapkey *k2)
 {
 	if (k1->hash != k2->hash || k1->len != k2->len)
 		return false;
-	return memcmp(k1->str, k2->str, k1->len) == 0;
+	return k1->str == k2->str || memcmp(k1->str, k2->str, k1->len) == 0;
 }
 
 static size_t
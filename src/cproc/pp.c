@@ -51,14 +51,19 @@ struct frame {
 enum ppflags ppflags;
 
 static struct array ctx;
-static struct map *macros;
+static struct map *macros, *keywords;
+static char *vaargs;
 /* number of macros currently undergoing expansion */
 static size_t macrodepth;
 
+static void keywordinit(void);
+
 void
 ppinit(void)
 {
 	macros = mkmap(64);
+	vaargs = intern("__VA_ARGS__", 11);
+	keywordinit();
 	next();
 }
 
@@ -75,7 +80,7 @@ macroequal(struct macro *m1, struct macro *m2)
 		if (m1->nparam != m2->nparam)
 			return false;
 		for (p1 = m1->param, p2 = m2->param; p1 < m1->param + m1->nparam; ++p1, ++p2) {
-			if (strcmp(p1->name, p2->name) != 0 || p1->flags != p2->flags)
+			if (p1->name != p2->name || p1->flags != p2->flags)
 				return false;
 		}
 	}
@@ -98,7 +103,7 @@ macroparam(struct macro *m, struct token *t)
 
 	if (t->kind == TIDENT) {
 		for (i = 0; i < m->nparam; ++i) {
-			if (strcmp(m->param[i].name, t->lit) == 0)
+			if (m->param[i].name == t->lit)
 				return i;
 		}
 	}
@@ -111,7 +116,7 @@ macroget(char *name)
 {
 	struct mapkey k;
 
-	mapkey(&k, name, strlen(name));
+	internkey(&k, name);
 	return mapget(macros, &k);
 }
 
@@ -231,7 +236,7 @@ define(void)
 			p = arrayadd(&params, sizeof(*p));
 			p->flags = 0;
 			if (tok.kind == TELLIPSIS) {
-				p->name = "__VA_ARGS__";
+				p->name = vaargs;
 				p->flags |= PARAMVAR;
 			} else {
 				p->name = tokencheck(&tok, TIDENT, "of macro parameter name or '...'");
@@ -252,7 +257,7 @@ define(void)
 		prev = t->kind;
 		t = arrayadd(&repl, sizeof(*t));
 		scan(t);
-		if (t->kind == TIDENT && strcmp(t->lit, "__VA_ARGS__") == 0 && !macrovarargs(m))
+		if (t->kind == TIDENT && t->lit == vaargs && !macrovarargs(m))
 			error(&t->loc, "__VA_ARGS__ can only be used in variadic function-like macros");
 		if (m->kind != MACROFUNC)
 			continue;
@@ -271,7 +276,7 @@ define(void)
 	m->ntoken = repl.len / sizeof(*t) - 1;
 	tok = *t;
 
-	mapkey(&k, m->name, strlen(m->name));
+	internkey(&k, m->name);
 	entry = mapput(macros, &k);
 	if (*entry && !macroequal(m, *entry))
 		error(&tok.loc, "redefinition of macro '%s'", m->name);
@@ -287,11 +292,10 @@ undef(void)
 	struct macro *m;
 
 	name = tokencheck(&tok, TIDENT, "after #undef");
-	mapkey(&k, name, strlen(name));
+	internkey(&k, name);
 	entry = mapput(macros, &k);
 	m = *entry;
 	if (m) {
-		free(name);
 		free(m->param);
 		free(m->token);
 		*entry = NULL;
@@ -338,7 +342,6 @@ directive(void)
 	} else {
 		error(&tok.loc, "invalid preprocessor directive #%s", name);
 	}
-	free(name);
 	tokencheck(&tok, TNEWLINE, "after preprocessing directive");
 	ppflags = oldflags;
 }
@@ -500,86 +503,92 @@ expand(struct token *t)
 	return true;
 }
 
+static const struct keyword {
+	const char *name;
+	int value;
+} keywordlist[] = {
+	{"_Alignas",       T_ALIGNAS},
+	{"_Alignof",       T_ALIGNOF},
+	{"_Atomic",        T_ATOMIC},
+	{"_Bool",          T_BOOL},
+	{"_Complex",       T_COMPLEX},
+	{"_Generic",       T_GENERIC},
+	{"_Imaginary",     T_IMAGINARY},
+	{"_Noreturn",      T_NORETURN},
+	{"_Static_assert", T_STATIC_ASSERT},
+	{"_Thread_local",  T_THREAD_LOCAL},
+	{"__alignof__",    T_ALIGNOF},
+	{"__asm",          T__ASM__},
+	{"__asm__",        T__ASM__},
+	{"__attribute__",  T__ATTRIBUTE__},
+	{"__inline",       TINLINE},
+	{"__inline__",     TINLINE},
+	{"__signed",       TSIGNED},
+	{"__signed__",     TSIGNED},
+	{"__thread",       T_THREAD_LOCAL},
+	{"__typeof",       T__TYPEOF__},
+	{"__typeof__",     T__TYPEOF__},
+	{"__volatile__",   TVOLATILE},
+	{"auto",           TAUTO},
+	{"break",          TBREAK},
+	{"case",           TCASE},
+	{"char",           TCHAR},
+	{"const",          TCONST},
+	{"continue",       TCONTINUE},
+	{"default",        TDEFAULT},
+	{"do",             TDO},
+	{"double",         TDOUBLE},
+	{"else",           TELSE},
+	{"enum",           TENUM},
+	{"extern",         TEXTERN},
+	{"float",          TFLOAT},
+	{"for",            TFOR},
+	{"goto",           TGOTO},
+	{"if",             TIF},
+	{"inline",         TINLINE},
+	{"int",            TINT},
+	{"long",           TLONG},
+	{"register",       TREGISTER},
+	{"restrict",       TRESTRICT},
+	{"return",         TRETURN},
+	{"short",          TSHORT},
+	{"signed",         TSIGNED},
+	{"sizeof",         TSIZEOF},
+	{"static",         TSTATIC},
+	{"struct",         TSTRUCT},
+	{"switch",         TSWITCH},
+	{"typedef",        TTYPEDEF},
+	{"union",          TUNION},
+	{"unsigned",       TUNSIGNED},
+	{"void",           TVOID},
+	{"volatile",       TVOLATILE},
+	{"while",          TWHILE},
+};
+
+static void
+keywordinit(void)
+{
+	const struct keyword *kw;
+	struct mapkey k;
+
+	keywords = mkmap(128);
+	for (kw = keywordlist; kw < keywordlist + LEN(keywordlist); ++kw) {
+		internkey(&k, intern(kw->name, strlen(kw->name)));
+		*mapput(keywords, &k) = (void *)kw;
+	}
+}
+
 static void
 keyword(struct token *tok)
 {
-	static const struct {
-		const char *name;
-		int value;
-	} keywords[] = {
-		{"_Alignas",       T_ALIGNAS},
-		{"_Alignof",       T_ALIGNOF},
-		{"_Atomic",        T_ATOMIC},
-		{"_Bool",          T_BOOL},
-		{"_Complex",       T_COMPLEX},
-		{"_Generic",       T_GENERIC},
-		{"_Imaginary",     T_IMAGINARY},
-		{"_Noreturn",      T_NORETURN},
-		{"_Static_assert", T_STATIC_ASSERT},
-		{"_Thread_local",  T_THREAD_LOCAL},
-		{"__alignof__",    T_ALIGNOF},
-		{"__asm",          T__ASM__},
-		{"__asm__",        T__ASM__},
-		{"__attribute__",  T__ATTRIBUTE__},
-		{"__inline",       TINLINE},
-		{"__inline__",     TINLINE},
-		{"__signed",       TSIGNED},
-		{"__signed__",     TSIGNED},
-		{"__thread",       T_THREAD_LOCAL},
-		{"__typeof",       T__TYPEOF__},
-		{"__typeof__",     T__TYPEOF__},
-		{"__volatile__",   TVOLATILE},
-		{"auto",           TAUTO},
-		{"break",          TBREAK},
-		{"case",           TCASE},
-		{"char",           TCHAR},
-		{"const",          TCONST},
-		{"continue",       TCONTINUE},
-		{"default",        TDEFAULT},
-		{"do",             TDO},
-		{"double",         TDOUBLE},
-		{"else",           TELSE},
-		{"enum",           TENUM},
-		{"extern",         TEXTERN},
-		{"float",          TFLOAT},
-		{"for",            TFOR},
-		{"goto",           TGOTO},
-		{"if",             TIF},
-		{"inline",         TINLINE},
-		{"int",            TINT},
-		{"long",           TLONG},
-		{"register",       TREGISTER},
-		{"restrict",       TRESTRICT},
-		{"return",         TRETURN},
-		{"short",          TSHORT},
-		{"signed",         TSIGNED},
-		{"sizeof",         TSIZEOF},
-		{"static",         TSTATIC},
-		{"struct",         TSTRUCT},
-		{"switch",         TSWITCH},
-		{"typedef",        TTYPEDEF},
-		{"union",          TUNION},
-		{"unsigned",       TUNSIGNED},
-		{"void",           TVOID},
-		{"volatile",       TVOLATILE},
-		{"while",          TWHILE},
-	};
-	size_t low = 0, high = LEN(keywords), mid;
-	int cmp;
-
-	while (low < high) {
-		mid = (low + high) / 2;
-		cmp = strcmp(tok->lit, keywords[mid].name);
-		if (cmp == 0) {
-			free(tok->lit);
-			tok->kind = keywords[mid].value;
-			tok->lit = NULL;
-			break;
-		}
-		if (cmp < 0)
-			high = mid;
-		else
-			low = mid + 1;
+	const struct keyword *kw;
+	struct mapkey k;
+
+	internkey(&k, tok->lit);
+	kw = mapget(keywords, &k);
+	if (kw) {
+		tok->kind = kw->value;
+		tok->lit = NULL;
 	}
 }
 
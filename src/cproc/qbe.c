@@ -419,6 +419,7 @@ convert(struct func *f, struct type *dst, struct type *src, struct value *l)
 struct func *
 mkfunc(struct decl *decl, char *name, struct type *t, struct scope *s)
 {
+	static char *funcname;
 	struct func *f;
 	struct param *p;
 	struct decl *d;
@@ -456,7 +457,9 @@ mkfunc(struct decl *decl, char *name, struct type *t, struct scope *s)
 	t = mkarraytype(&typechar, QUALCONST, strlen(name) + 1);
 	d = mkdecl(DECLOBJECT, t, QUALNONE, LINKNONE);
 	d->value = mkglobal("__func__", true);
-	scopeputdecl(s, "__func__", d);
+	if (!funcname)
+		funcname = intern("__func__", 8);
+	scopeputdecl(s, funcname, d);
 	f->namedecl = d;
 
 	funclabel(f, mkblock("body"));
@@ -536,7 +539,7 @@ funcgoto(struct func *f, char *name)
 	struct gotolabel *g;
 	struct mapkey key;
 
-	mapkey(&key, name, strlen(name));
+	internkey(&key, name);
 	entry = mapput(f->gotos, &key);
 	g = *entry;
 	if (!g) {
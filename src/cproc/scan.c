@@ -8,9 +8,13 @@
 #include "util.h"
 #include "cc.h"
 
-struct buffer {
-	char *str;
-	size_t len, cap;
+struct source {
+	const char *name;
+	/* location of the first character of the file */
+	uint32_t base;
+	/* offset of the start of each line from the start of the file */
+	uint32_t *line;
+	size_t nline;
 };
 
 struct scanner {
@@ -18,58 +22,43 @@ struct scanner {
 	bool usebuf;
 	bool sawspace;
 	FILE *file;
+	struct source *source;
+	/* contents of the file with line splices removed, read in one piece when it is opened */
+	char *src, *pos, *end;
+	/* start of the current token in the source buffer */
+	char *tok;
+	/* where the last literal was terminated, and the character that was there */
+	char *term;
+	int termchr;
 	struct location loc;
-	struct buffer buf;
 	struct scanner *next;
 };
 
 static struct scanner *scanner;
+/* sources in order of increasing base */
+static struct array sources;
+/* location of the first character of the next source */
+static uint32_t nextbase = 1;
 
 static void
-bufadd(struct buffer *b, char c)
+nextchar(struct scanner *s)
 {
-	if (b->len >= b->cap) {
-		b->cap = b->cap ? b->cap * 2 : 1<<8;
-		b->str = xreallocarray(b->str, b->cap, 1);
-	}
-	b->str[b->len++] = c;
+	s->chr = s->pos != s->end ? (unsigned char)*s->pos++ : EOF;
 }
 
-static char *
-bufget(struct buffer *b)
+/* advance to p in the source buffer */
+static void
+skipto(struct scanner *s, const char *p)
 {
-	char *s;
-
-	bufadd(b, '\0');
-	s = xmalloc(b->len);
-	memcpy(s, b->str, b->len);
-	b->len = 0;
-
-	return s;
+	s->pos = (char *)p;
 }
 
-static void
-nextchar(struct scanner *s)
+/* the location of the current character */
+static struct location *
+location(struct scanner *s)
 {
-	int c;
-
-	if (s->usebuf)
-		bufadd(&s->buf, s->chr);
-	for (;;) {
-		s->chr = getc(s->file);
-		if (s->chr == '\n')
-			++s->loc.line, s->loc.col = 1;
-		else
-			++s->loc.col;
-		if (s->chr != '\\')
-			break;
-		c = getc(s->file);
-		if (c != '\n') {
-			ungetc(c, s->file);
-			break;
-		}
-		++s->loc.line, s->loc.col = 1;
-	}
+	s->loc.off = s->source->base + (s->pos - (s->chr != EOF) - s->src);
+	return &s->loc;
 }
 
 static int
@@ -123,8 +112,10 @@ static int
 ident(struct scanner *s)
 {
 	s->usebuf = true;
-	while (isalnum(s->chr) || s->chr == '_')
+	if (isalnum(s->chr) || s->chr == '_') {
+		skipto(s, spanident(s->pos, s->end));
 		nextchar(s);
+	}
 
 	return TIDENT;
 }
@@ -176,7 +167,7 @@ escape(struct scanner *s)
 	if (s->chr == 'x') {
 		nextchar(s);
 		if (!isxdigit(s->chr))
-			error(&s->loc, "invalid hexadecimal escape sequence");
+			error(location(s), "invalid hexadecimal escape sequence");
 		do nextchar(s);
 		while (isxdigit(s->chr));
 	} else if (isodigit(s->chr)) {
@@ -189,7 +180,7 @@ escape(struct scanner *s)
 	} else if (strchr("'\"?\\abfnrtv", s->chr)) {
 		nextchar(s);
 	} else {
-		error(&s->loc, "invalid escape sequence");
+		error(location(s), "invalid escape sequence");
 	}
 }
 
@@ -207,9 +198,9 @@ charconst(struct scanner *s)
 			nextchar(s);
 			return TCHARCONST;
 		case '\n':
-			error(&s->loc, "newline in character constant");
+			error(location(s), "newline in character constant");
 		case EOF:
-			error(&s->loc, "EOF in character constant");
+			error(location(s), "EOF in character constant");
 		default:
 			nextchar(s);
 			break;
@@ -231,10 +222,11 @@ stringlit(struct scanner *s)
 			nextchar(s);
 			return TSTRINGLIT;
 		case '\n':
-			error(&s->loc, "newline in string literal");
+			error(location(s), "newline in string literal");
 		case EOF:
-			error(&s->loc, "EOF in string literal");
+			error(location(s), "EOF in string literal");
 		default:
+			skipto(s, spanuntil(s->pos, s->end, '"', '\\', '\n'));
 			nextchar(s);
 			break;
 		}
@@ -248,16 +240,18 @@ comment(struct scanner *s)
 
 	switch (s->chr) {
 	case '/':  /* C++-style comment */
-		do nextchar(s);
-		while (s->chr != '\n' && s->chr != EOF);
+		skipto(s, spanuntil(s->pos, s->end, '\n', '\n', '\n'));
+		nextchar(s);
 		break;
 	case '*':  /* C-style comment */
 		nextchar(s);
 		do {
+			if (s->chr != '*')
+				skipto(s, spanuntil(s->pos, s->end, '*', '*', '*'));
 			last = s->chr;
 			nextchar(s);
 			if (s->chr == EOF)
-				error(&s->loc, "EOF in comment");
+				error(location(s), "EOF in comment");
 		} while (last != '*' || s->chr != '/');
 		nextchar(s);
 		break;
@@ -272,15 +266,17 @@ static int
 scankind(struct scanner *s)
 {
 	enum tokenkind tok;
-	struct location loc;
+	int c;
 
 again:
+	s->tok = s->pos - (s->chr != EOF);
 	switch (s->chr) {
 	case ' ':
 	case '\t':
 	case '\f':
 	case '\v':
 		s->sawspace = true;
+		skipto(s, spanblank(s->pos, s->end));
 		nextchar(s);
 		goto again;
 	case '!':
@@ -347,20 +343,11 @@ again:
 		return TRBRACE;
 	case '.':
 		nextchar(s);
-		if (isdigit(s->chr)) {
-			bufadd(&s->buf, '.');
+		if (isdigit(s->chr))
 			return number(s);
-		}
-		if (s->chr != '.')
+		if (s->chr != '.' || s->pos == s->end || *s->pos != '.')
 			return TPERIOD;
-		loc = s->loc;
 		nextchar(s);
-		if (s->chr != '.') {
-			ungetc(s->chr, s->file);
-			s->loc = loc;
-			s->chr = '.';
-			return TPERIOD;
-		}
 		nextchar(s);
 		return TELLIPSIS;
 	case '~':
@@ -385,12 +372,13 @@ again:
 	case 'U':
 	case 'u':
 		s->usebuf = true;
+		c = s->chr;
 		nextchar(s);
 		switch (s->chr) {
 		case '\'':
 			return charconst(s);
 		case '8':
-			if (s->buf.str[0] != 'u')
+			if (c != 'u')
 				break;
 			nextchar(s);
 			if (s->chr != '"')
@@ -413,6 +401,71 @@ again:
 	}
 }
 
+/* remove line splices from the source buffer, recording where each line starts */
+static void
+unsplice(struct scanner *s)
+{
+	struct array lines = {0};
+	char *src, *dst, *end, *p;
+	size_t n;
+	bool splice, newline;
+
+	src = dst = s->src;
+	end = s->end;
+	*(uint32_t *)arrayadd(&lines, sizeof(uint32_t)) = 0;
+	for (;;) {
+		p = (char *)spanuntil(src, end, '\\', '\n', '\n');
+		if (p == end)
+			break;
+		splice = p[0] == '\\' && p + 1 != end && p[1] == '\n';
+		newline = splice || p[0] == '\n';
+		if (!splice)
+			++p;
+		n = p - src;
+		if (dst != src)
+			memmove(dst, src, n);
+		dst += n;
+		src = splice ? p + 2 : p;
+		if (newline)
+			*(uint32_t *)arrayadd(&lines, sizeof(uint32_t)) = dst - s->src;
+	}
+	n = end - src;
+	if (dst != src)
+		memmove(dst, src, n);
+	s->end = dst + n;
+	s->source->line = lines.val;
+	s->source->nline = lines.len / sizeof(uint32_t);
+}
+
+static void
+scanread(struct scanner *s)
+{
+	size_t len, cap, n;
+
+	len = 0;
+	cap = 1<<14;
+	s->src = NULL;
+	do {
+		if (len == cap)
+			cap *= 2;
+		/* leave room to terminate a literal at the end of the file */
+		s->src = xreallocarray(s->src, cap + 1, 1);
+		n = fread(s->src + len, 1, cap - len, s->file);
+		len += n;
+	} while (n > 0);
+	if (ferror(s->file))
+		fatal("read %s:", s->source->name);
+	if (len > UINT32_MAX - nextbase)
+		fatal("%s: too much source", s->source->name);
+	s->source->base = nextbase;
+	nextbase += len + 1;
+	arrayaddptr(&sources, s->source);
+	s->pos = s->src;
+	s->end = s->src + len;
+	unsplice(s);
+	nextchar(s);
+}
+
 void
 scanfrom(const char *name, FILE *file)
 {
@@ -420,16 +473,13 @@ scanfrom(const char *name, FILE *file)
 
 	s = xmalloc(sizeof(*s));
 	s->file = file;
-	s->buf.str = NULL;
-	s->buf.len = 0;
-	s->buf.cap = 0;
 	s->usebuf = false;
-	s->loc.file = name;
-	s->loc.line = 1;
-	s->loc.col = 0;
+	s->term = NULL;
+	s->source = xmalloc(sizeof(*s->source));
+	s->source->name = name;
 	s->next = scanner;
 	if (file)
-		nextchar(s);
+		scanread(s);
 	scanner = s;
 }
 
@@ -437,36 +487,69 @@ void
 scanopen(void)
 {
 	if (!scanner->file) {
-		scanner->file = fopen(scanner->loc.file, "r");
+		scanner->file = fopen(scanner->source->name, "r");
 		if (!scanner->file)
-			fatal("open %s:", scanner->loc.file);
-		nextchar(scanner);
+			fatal("open %s:", scanner->source->name);
+		scanread(scanner);
 	}
 }
 
 static void
 scanclose(void)
 {
-	fclose(scanner->file);
-	free(scanner->buf.str);
-	free(scanner);
+	struct scanner *s;
+
+	s = scanner;
+	scanner = s->next;
+	fclose(s->file);
+	/* the source buffer is kept, since token literals point into it */
+	free(s);
 }
 
 void
 scan(struct token *t)
 {
+	char *lit, *end;
+
 	scanner->sawspace = false;
 	for (;;) {
-		t->loc = scanner->loc;
 		t->kind = scankind(scanner);
 		if (t->kind != TEOF || !scanner->next)
 			break;
 		scanclose();
-		scanner = scanner->next;
 		scanopen();
 	}
+	t->loc.off = scanner->source->base + (scanner->tok - scanner->src);
 	if (scanner->usebuf) {
-		t->lit = bufget(&scanner->buf);
+		lit = scanner->tok;
+		end = scanner->pos - (scanner->chr != EOF);
+		if (lit == scanner->term) {
+			/* the first character was overwritten to terminate the previous literal */
+			t->lit = xmalloc(end - lit + 1);
+			t->lit[0] = scanner->termchr;
+			memcpy(t->lit + 1, lit + 1, end - lit - 1);
+			end = t->lit + (end - lit);
+			lit = t->lit;
+		}
+		if (t->kind == TIDENT) {
+			t->lit = intern(lit, end - lit);
+			if (lit != scanner->tok)
+				free(lit);
+			++stats.idents;
+		} else {
+			/*
+			Other literals are terminated in place. The character
+			following the literal has already been read into
+			scanner->chr, so the source buffer is not consulted
+			for it again.
+			*/
+			if (lit == scanner->tok) {
+				scanner->term = end;
+				scanner->termchr = *end;
+			}
+			*end = '\0';
+			t->lit = lit;
+		}
 		scanner->usebuf = false;
 	} else {
 		t->lit = NULL;
@@ -474,3 +557,40 @@ scan(struct token *t)
 	t->space = scanner->sawspace;
 	t->hide = false;
 }
+
+/* find the file, line and column of a location */
+const char *
+scanlocate(const struct location *loc, size_t *line, size_t *col)
+{
+	struct source **sp, *s;
+	uint32_t off;
+	size_t lo, hi, mid;
+
+	off = loc->off;
+	sp = sources.val;
+	lo = 0;
+	hi = sources.len / sizeof(*sp);
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (sp[mid]->base <= off)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == 0)
+		return NULL;
+	s = sp[lo - 1];
+	off -= s->base;
+	lo = 0;
+	hi = s->nline;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (s->line[mid] <= off)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	*line = lo;
+	*col = off - s->line[lo - 1] + 1;
+	return s->name;
+}
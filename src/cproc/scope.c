@@ -31,7 +31,7 @@ scopeinit(void)
 	struct builtin *b;
 
 	for (b = builtins; b < builtins + LEN(builtins); ++b)
-		scopeputdecl(&filescope, b->name, &b->decl);
+		scopeputdecl(&filescope, intern(b->name, strlen(b->name)), &b->decl);
 }
 
 struct scope *
@@ -64,13 +64,15 @@ delscope(struct scope *s)
 	return parent;
 }
 
+/* identifier names passed to these functions must be interned */
+
 struct decl *
 scopegetdecl(struct scope *s, const char *name, bool recurse)
 {
 	struct decl *d;
 	struct mapkey k;
 
-	mapkey(&k, name, strlen(name));
+	internkey(&k, name);
 	do {
 		d = s->decls ? mapget(s->decls, &k) : NULL;
 		s = s->parent;
@@ -85,7 +87,7 @@ scopegettag(struct scope *s, const char *name, bool recurse)
 	struct type *t;
 	struct mapkey k;
 
-	mapkey(&k, name, strlen(name));
+	internkey(&k, name);
 	do {
 		t = s->tags ? mapget(s->tags, &k) : NULL;
 		s = s->parent;
@@ -101,7 +103,7 @@ scopeputdecl(struct scope *s, const char *name, struct decl *d)
 
 	if (!s->decls)
 		s->decls = mkmap(32);
-	mapkey(&k, name, strlen(name));
+	internkey(&k, name);
 	*mapput(s->decls, &k) = d;
 }
 
@@ -112,6 +114,6 @@ scopeputtag(struct scope *s, const char *name, struct type *t)
 
 	if (!s->tags)
 		s->tags = mkmap(32);
-	mapkey(&k, name, strlen(name));
+	internkey(&k, name);
 	*mapput(s->tags, &k) = t;
 }
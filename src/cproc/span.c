@@ -0,0 +1,175 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "util.h"
+#include "cc.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SPANVEC 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define SPANVEC 16
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SPANVEC 16
+#endif
+
+/*
+These routines find the end of a run of characters in the source
+buffer, SPANVEC bytes at a time where the target has vector
+instructions. Line splices have already been removed from the buffer,
+so a run never needs to stop at a backslash-newline.
+*/
+
+static bool
+identchar(int c)
+{
+	return (unsigned)(c | 0x20) - 'a' < 26 || (unsigned)c - '0' < 10 || c == '_';
+}
+
+static bool
+blankchar(int c)
+{
+	return c == ' ' || c == '\t' || c == '\f' || c == '\v';
+}
+
+static const char *
+spanidentscalar(const char *p, const char *end)
+{
+	while (p < end && identchar((unsigned char)*p))
+		++p;
+	return p;
+}
+
+static const char *
+spanblankscalar(const char *p, const char *end)
+{
+	while (p < end && blankchar((unsigned char)*p))
+		++p;
+	return p;
+}
+
+static const char *
+spanuntilscalar(const char *p, const char *end, int c1, int c2, int c3)
+{
+	while (p < end && *p != c1 && *p != c2 && *p != c3)
+		++p;
+	return p;
+}
+
+#if defined(__AVX2__)
+
+typedef __m256i vec;
+
+#define vload(p)      _mm256_loadu_si256((const __m256i *)(p))
+#define vdup(c)       _mm256_set1_epi8(c)
+#define veq(x, y)     _mm256_cmpeq_epi8(x, y)
+#define vor(x, y)     _mm256_or_si256(x, y)
+#define vnot(x)       _mm256_xor_si256(x, vdup(-1))
+/* whether each byte of x, as an unsigned value, is in [lo, hi] */
+#define vrange(x, lo, hi) _mm256_cmpgt_epi8(vdup((hi) - (lo) + 1 - 128), _mm256_add_epi8(x, vdup(128 - (lo))))
+
+/* index of the first set byte of a comparison mask, or SPANVEC if none is set */
+static int
+vfirst(vec m)
+{
+	uint32_t b = _mm256_movemask_epi8(m);
+
+	return b ? __builtin_ctz(b) : SPANVEC;
+}
+
+#elif defined(__SSE2__)
+
+typedef __m128i vec;
+
+#define vload(p)      _mm_loadu_si128((const __m128i *)(p))
+#define vdup(c)       _mm_set1_epi8(c)
+#define veq(x, y)     _mm_cmpeq_epi8(x, y)
+#define vor(x, y)     _mm_or_si128(x, y)
+#define vnot(x)       _mm_xor_si128(x, vdup(-1))
+#define vrange(x, lo, hi) _mm_cmpgt_epi8(vdup((hi) - (lo) + 1 - 128), _mm_add_epi8(x, vdup(128 - (lo))))
+
+static int
+vfirst(vec m)
+{
+	unsigned b = _mm_movemask_epi8(m);
+
+	return b ? __builtin_ctz(b) : SPANVEC;
+}
+
+#elif defined(__ARM_NEON)
+
+typedef uint8x16_t vec;
+
+#define vload(p)      vld1q_u8((const uint8_t *)(p))
+#define vdup(c)       vdupq_n_u8(c)
+#define veq(x, y)     vceqq_u8(x, y)
+#define vor(x, y)     vorrq_u8(x, y)
+#define vnot(x)       vmvnq_u8(x)
+#define vrange(x, lo, hi) vcltq_u8(vsubq_u8(x, vdup(lo)), vdup((hi) - (lo) + 1))
+
+static int
+vfirst(vec m)
+{
+	/* narrow each byte of the mask to a nibble */
+	uint64_t b = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+
+	return b ? __builtin_ctzll(b) / 4 : SPANVEC;
+}
+
+#endif
+
+const char *
+spanident(const char *p, const char *end)
+{
+#ifdef SPANVEC
+	vec x;
+	int i;
+
+	for (; end - p >= SPANVEC; p += SPANVEC) {
+		x = vload(p);
+		i = vfirst(vnot(vor(vor(vrange(vor(x, vdup(0x20)), 'a', 'z'), vrange(x, '0', '9')), veq(x, vdup('_')))));
+		if (i < SPANVEC)
+			return p + i;
+	}
+#endif
+	return spanidentscalar(p, end);
+}
+
+const char *
+spanblank(const char *p, const char *end)
+{
+#ifdef SPANVEC
+	vec x;
+	int i;
+
+	for (; end - p >= SPANVEC; p += SPANVEC) {
+		x = vload(p);
+		i = vfirst(vnot(vor(vor(veq(x, vdup(' ')), veq(x, vdup('\t'))), vor(veq(x, vdup('\f')), veq(x, vdup('\v'))))));
+		if (i < SPANVEC)
+			return p + i;
+	}
+#endif
+	return spanblankscalar(p, end);
+}
+
+const char *
+spanuntil(const char *p, const char *end, int c1, int c2, int c3)
+{
+#ifdef SPANVEC
+	vec x, v1, v2, v3;
+	int i;
+
+	v1 = vdup(c1);
+	v2 = vdup(c2);
+	v3 = vdup(c3);
+	for (; end - p >= SPANVEC; p += SPANVEC) {
+		x = vload(p);
+		i = vfirst(vor(vor(veq(x, v1), veq(x, v2)), veq(x, v3)));
+		if (i < SPANVEC)
+			return p + i;
+	}
+#endif
+	return spanuntilscalar(p, end, c1, c2, c3);
+}
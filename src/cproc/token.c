@@ -185,8 +185,14 @@ tokencheck(const struct token *t, enum tokenkind kind, const char *msg)
 _Noreturn void error(const struct location *loc, const char *fmt, ...)
 {
 	va_list ap;
+	const char *file;
+	size_t line, col;
 
-	fprintf(stderr, "%s:%zu:%zu: error: ", loc->file, loc->line, loc->col);
+	file = scanlocate(loc, &line, &col);
+	if (file)
+		fprintf(stderr, "%s:%zu:%zu: error: ", file, line, col);
+	else
+		fprintf(stderr, "%s: error: ", argv0);
 	va_start(ap, fmt);
 	vfprintf(stderr, fmt, ap);
 	va_end(ap);
@@ -9,6 +9,7 @@
 #include "util.h"
 
 char *argv0;
+struct stats stats;
 
 static void
 vwarn(const char *fmt, va_list ap)
@@ -26,7 +26,14 @@ struct treenode {
 	_Bool new;  /* set by treeinsert if this node was newly allocated */
 };
 
+/* statistics reported with -s */
+struct stats {
+	unsigned long long idents;  /* identifiers scanned */
+	unsigned long long hashes;  /* map keys hashed */
+};
+
 extern char *argv0;
+extern struct stats stats;
 
 #define LEN(a) (sizeof(a) / sizeof((a)[0]))
 #define ALIGNDOWN(x, n) ((x) & -(n))
@@ -59,6 +66,11 @@ void delmap(struct map *, void(void *));
 void **mapput(struct map *, struct mapkey *);
 void *mapget(struct map *, struct mapkey *);
 
+/* intern */
+
+char *intern(const char *, size_t);
+void internkey(struct mapkey *, const char *);
+
 /* tree */
 
 void *treeinsert(void **, uint64_t, size_t);